@@ -3,8 +3,8 @@
 
 typedef struct ast_node {
     char* node_type;      // e.g., "args", "identifier", etc.
-    char* type;           // e.g., "int", "float", etc.
-    char* value;          // node value
+    const char* type;     // e.g., "int", "float", etc., interned
+    const char* value;    // interned name, or owned literal text
     struct ast_node* left;
     struct ast_node* right;
 } ast_node;
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "incremental.h"
+
+// Times the front end over one source file, built against the real
+// lexer by bench/run.sh:
+//
+//   bench_lexer lex FILE       loads FILE and runs yylex() to the end
+//   bench_lexer compile FILE   loads FILE and runs compile_source()
+//
+// Built with -DBASELINE it loads and lexes the way the tree did before
+// sources were mapped and scanned in place, for comparison.
+
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+void yy_delete_buffer(YY_BUFFER_STATE buffer);
+int yylex(void);
+char* read_source(FILE* in, int* len);
+#ifdef BASELINE
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len);
+#else
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size);
+char* map_source(const char* path, int* len);
+#endif
+
+static char* load(const char* path, int* len) {
+#ifdef BASELINE
+    FILE* in = fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "Error: Cannot read '%s'\n", path);
+        exit(1);
+    }
+    char* src = read_source(in, len);
+    fclose(in);
+    return src;
+#else
+    return map_source(path, len);
+#endif
+}
+
+static long lex_all(char* src, int len) {
+#ifdef BASELINE
+    YY_BUFFER_STATE buffer = yy_scan_bytes(src, len);
+#else
+    YY_BUFFER_STATE buffer = yy_scan_buffer(src, len + 2);
+#endif
+    long tokens = 0;
+    while (yylex() != 0) tokens++;
+    yy_delete_buffer(buffer);
+    return tokens;
+}
+
+static double seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3 || (strcmp(argv[1], "lex") != 0 && strcmp(argv[1], "compile") != 0)) {
+        fprintf(stderr, "Usage: %s lex|compile FILE\n", argv[0]);
+        return 1;
+    }
+
+    double start = seconds();
+    int len;
+    char* src = load(argv[2], &len);
+    if (strcmp(argv[1], "lex") == 0) {
+        long tokens = lex_all(src, len);
+        double elapsed = seconds() - start;
+        printf("lex:     %d bytes, %ld tokens, %.3f s, %.1f MB/s\n",
+               len, tokens, elapsed, len / elapsed / 1e6);
+    } else {
+        compile_source(src, len);
+        double elapsed = seconds() - start;
+        printf("compile: %d bytes, %.3f s, %.1f MB/s\n", len, elapsed, len / elapsed / 1e6);
+    }
+    return 0;
+}
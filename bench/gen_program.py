@@ -0,0 +1,71 @@
+"""Generates VibeScript inputs for bench/run.sh.
+
+    gen_program.py big OUT [FUNCTIONS] [BLOCKS]
+        One large program: FUNCTIONS functions of BLOCKS blocks each, plus
+        a main that calls the first. The defaults give about 26 MB.
+
+    gen_program.py pages DIR PAGE_SIZE
+        Small programs whose function spans end exactly on page
+        boundaries, where the two bytes the lexer borrows after a span lie
+        at the start of the next page or past the end of the file.
+"""
+import os
+import sys
+
+
+def block(j):
+    name = f"alpha_{j % 7}"
+    return (f"  {{ vibe int {name} = {j}; vibe int beta_value = {name} + 2; "
+            f"{name} = {name} * beta_value; "
+            f"yah beta_value > 3 {{ vibe string msg = \"item {j}\"; }} }}\n")
+
+
+def big_program(functions, blocks):
+    body = "".join(block(j) for j in range(blocks))
+    parts = [f"plot int func_{k}() {{\n{body}  drop {k};\n}}\n" for k in range(functions)]
+    parts.append("plot int main() {\n  vibe int r = func_0();\n  spill r;\n  drop 0;\n}\n")
+    return "".join(parts)
+
+
+def padded_function(name, message, length):
+    """A function of exactly length bytes whose last byte is its closing
+    brace; the padding is an identifier that crosses into the next page
+    for long spans."""
+    head = f"plot int {name}() {{\n    spill \"{message}\";\n    vibe int "
+    tail = " = 1;\n    drop 7;\n}"
+    pad = length - len(head) - len(tail)
+    if pad < 1:
+        raise ValueError(f"{length} bytes is too short for {name}")
+    return head + "p" * pad + tail
+
+
+def page_programs(page):
+    main = "\nplot int main() {\n    spill \"main\";\n    drop 0;\n}"
+    return {
+        # The file is exactly one page: the borrowed bytes are past its end.
+        "file_on_page.vibe": padded_function("helper", "helper", page - len(main)) + main,
+        # The first span ends on the page boundary: the borrowed bytes are
+        # the start of main, in the next page of the file.
+        "span_on_page.vibe": padded_function("helper", "helper", page) + main,
+        # One borrowed byte is the last of the file's page, one lies past it.
+        "file_before_page.vibe": padded_function("helper", "helper", page - 1 - len(main)) + main,
+    }
+
+
+def main(argv):
+    if len(argv) >= 3 and argv[1] == "big":
+        functions = int(argv[3]) if len(argv) > 3 else 98
+        blocks = int(argv[4]) if len(argv) > 4 else 1800
+        with open(argv[2], "w") as out:
+            out.write(big_program(functions, blocks))
+    elif len(argv) == 4 and argv[1] == "pages":
+        os.makedirs(argv[2], exist_ok=True)
+        for name, source in page_programs(int(argv[3])).items():
+            with open(os.path.join(argv[2], name), "w") as out:
+                out.write(source)
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,63 @@
+#!/bin/sh
+# Builds vibe and bench_lexer with flex and bison, checks that lexing in
+# place over a mapped file works when a span ends on a page boundary, and
+# times the lexer and the whole front end on a generated 26 MB program.
+#
+#   bench/run.sh [BASELINE_REV]
+#
+# With BASELINE_REV, the commit before in-place lexing for example, the
+# same program is also timed against that revision. Set BENCH_DIR to keep
+# the build and inputs somewhere other than a temporary directory.
+set -e
+
+repo=$(cd "$(dirname "$0")/.." && pwd)
+work=${BENCH_DIR:-$(mktemp -d)}
+page=$(getconf PAGESIZE)
+runs=3
+
+# build SOURCE_DIR BUILD_DIR [HARNESS_CFLAGS]
+build() {
+    mkdir -p "$2"
+    (
+        set -e
+        cd "$2"
+        bison -d -o parser.tab.c "$1/parser.y"
+        flex -o lex.yy.c "$1/lexer.l"
+        gcc -O2 -I"$1" -o vibe parser.tab.c lex.yy.c "$1"/*.c
+        gcc -O2 -I"$1" -Dmain=vibe_main -c -o parser_lib.o parser.tab.c
+        gcc -O2 -I"$1" $3 -o bench_lexer "$repo/bench/bench_lexer.c" parser_lib.o lex.yy.c "$1"/*.c
+    )
+}
+
+build "$repo" "$work/current"
+
+echo "== compile cache"
+python3 "$repo/tests/check_cache.py" "$work/current/vibe"
+
+echo "== page boundaries ($page byte pages)"
+python3 "$repo/bench/gen_program.py" pages "$work/pages" "$page"
+for program in "$work"/pages/*.vibe; do
+    "$work/current/vibe" "$program" > "$work/mapped.out" 2>&1 || true
+    "$work/current/vibe" < "$program" > "$work/read.out" 2>&1 || true
+    if cmp -s "$work/mapped.out" "$work/read.out" && grep -q "function (main)" "$work/mapped.out"; then
+        echo "ok      $(basename "$program")"
+    else
+        echo "FAILED  $(basename "$program"): see $work/mapped.out and $work/read.out"
+        exit 1
+    fi
+done
+
+python3 "$repo/bench/gen_program.py" big "$work/big.vibe"
+
+if [ -n "$1" ]; then
+    mkdir -p "$work/baseline-src"
+    git -C "$repo" archive "$1" | tar -x -C "$work/baseline-src"
+    build "$work/baseline-src" "$work/baseline" -DBASELINE
+    echo "== baseline ($1)"
+    for i in $(seq $runs); do "$work/baseline/bench_lexer" lex "$work/big.vibe"; done
+    for i in $(seq $runs); do "$work/baseline/bench_lexer" compile "$work/big.vibe"; done
+fi
+
+echo "== current"
+for i in $(seq $runs); do "$work/current/bench_lexer" lex "$work/big.vibe"; done
+for i in $(seq $runs); do "$work/current/bench_lexer" compile "$work/big.vibe"; done
@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "ast.h"
+#include "vibe.h"
+#include "incremental.h"
+
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size);
+void yy_delete_buffer(YY_BUFFER_STATE buffer);
+int yyparse(void);
+ast_node* create_node(char* type, ast_node* left, ast_node* right, const char* value);
+void check_main_defined();
+
+extern ast_node* root;
+
+// Units are kept across compiles, and across the different programs a
+// shared compiler sees, until their slot is needed for a new one.
+#define MAX_UNITS 1000
+#define MAX_UNIT_CALLS 20
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// One parsed and checked `plot` function, keyed by its source span.
+typedef struct CachedUnit {
+    unsigned long long hash;
+    char* text;                                     // copy of the span
+    int length;
+    ast_node* ast;
+    FunctionInfo info;
+    const char* calls[MAX_UNIT_CALLS];
+    unsigned long long call_sigs[MAX_UNIT_CALLS];   // callee signatures seen when checked
+    int call_count;
+    int cacheable;
+    int used;                                       // part of the program being compiled
+    unsigned long last_used;                        // compile that last used it
+} CachedUnit;
+
+static CachedUnit units[MAX_UNITS];
+static int unit_count = 0;
+static unsigned long compile_count = 0;
+static CachedUnit* parsing_unit = NULL;
+static YY_BUFFER_STATE parsing_buffer = NULL;
+static char* span_end = NULL;
+static char saved_tail[2];
+static ast_node* program = NULL;
+static jmp_buf* error_jump = NULL;
+
+static unsigned long long hash_bytes(unsigned long long h, const char* s, int len) {
+    for (int i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static unsigned long long signature_hash(const FunctionInfo* func) {
+    unsigned long long h = hash_bytes(FNV_OFFSET, func->return_type, strlen(func->return_type) + 1);
+    for (int i = 0; i < func->param_count; i++) {
+        h = hash_bytes(h, func->param_types[i], strlen(func->param_types[i]) + 1);
+    }
+    return h;
+}
+
+static FunctionInfo* find_function(const char* name) {
+    for (int i = 0; i < func_count; i++) {
+        if (functions[i].name == name) {
+            return &functions[i];
+        }
+    }
+    return NULL;
+}
+
+static int is_literal(const ast_node* node) {
+    return strcmp(node->node_type, "INT") == 0 || strcmp(node->node_type, "FLOAT") == 0 ||
+           strcmp(node->node_type, "STRING") == 0 || strcmp(node->node_type, "BOOL") == 0;
+}
+
+// Names and types are interned and shared between trees. Literal values
+// are not, so that a long-running compiler does not keep every literal
+// it has ever seen: they belong to their node.
+static void free_ast(ast_node* node) {
+    if (!node) return;
+    free_ast(node->left);
+    free_ast(node->right);
+    if (is_literal(node)) free((char*)node->value);
+    free(node->node_type);
+    free(node);
+}
+
+// Frees the "functions" nodes that chained the previous program together;
+// the function nodes they point to are owned by the cache.
+static void free_program_chain() {
+    while (program && strcmp(program->node_type, "functions") == 0) {
+        ast_node* next = program->left;
+        free(program->node_type);
+        free(program);
+        program = next;
+    }
+    program = NULL;
+}
+
+// Lets flex scan src[0..len) where it lies: it needs two NUL bytes after
+// the text, so the two bytes after the span are saved and restored later.
+static void scan_in_place(char* src, int len) {
+    span_end = src + len;
+    memcpy(saved_tail, span_end, 2);
+    span_end[0] = span_end[1] = '\0';
+    parsing_buffer = yy_scan_buffer(src, len + 2);
+}
+
+static void end_scan() {
+    if (parsing_buffer) {
+        yy_delete_buffer(parsing_buffer);
+        parsing_buffer = NULL;
+    }
+    if (span_end) {
+        memcpy(span_end, saved_tail, 2);
+        span_end = NULL;
+    }
+}
+
+// Returns the end of the span starting at start: everything up to and
+// including the brace that closes the next function body.
+static int next_span_end(const char* src, int start, int len) {
+    int depth = 0;
+    for (int i = start; i < len; i++) {
+        if (src[i] == '"') {
+            while (++i < len && src[i] != '"');
+        } else if (src[i] == '{') {
+            depth++;
+        } else if (src[i] == '}') {
+            if (--depth <= 0) return i + 1;
+        }
+    }
+    return len;
+}
+
+static int is_blank(const char* src, int start, int end) {
+    for (int i = start; i < end; i++) {
+        if (src[i] != ' ' && src[i] != '\t' && src[i] != '\n') return 0;
+    }
+    return 1;
+}
+
+// A cached function is only valid while every function it calls still has
+// the signature it was checked against.
+static int unit_is_current(CachedUnit* unit) {
+    for (int i = 0; i < unit->call_count; i++) {
+        FunctionInfo* callee = find_function(unit->calls[i]);
+        if (!callee || signature_hash(callee) != unit->call_sigs[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Finds an unused unit parsed from exactly these bytes. The hash only
+// narrows the search: spans are compared byte for byte, so a colliding
+// span can never pick up another program's function.
+static CachedUnit* find_unit(unsigned long long hash, const char* src, int length) {
+    for (int i = 0; i < unit_count; i++) {
+        CachedUnit* unit = &units[i];
+        if (unit->hash == hash && unit->length == length && !unit->used &&
+            memcmp(unit->text, src, length) == 0) {
+            return unit;
+        }
+    }
+    return NULL;
+}
+
+static void free_unit(CachedUnit* unit) {
+    free_ast(unit->ast);
+    free(unit->text);
+}
+
+// Takes a free slot, or else the least recently used unit that the
+// program being compiled does not use.
+static CachedUnit* claim_unit_slot() {
+    if (unit_count < MAX_UNITS) {
+        return &units[unit_count++];
+    }
+    CachedUnit* oldest = NULL;
+    for (int i = 0; i < unit_count; i++) {
+        if (!units[i].used && (!oldest || units[i].last_used < oldest->last_used)) {
+            oldest = &units[i];
+        }
+    }
+    if (!oldest) {
+        fprintf(stderr, "Error: Too many functions\n");
+        abort_compile();
+    }
+    free_unit(oldest);
+    return oldest;
+}
+
+static void parse_unit(CachedUnit* unit, char* src, int len) {
+    int first_function = func_count;
+
+    // Functions never see each other's locals, so each one starts from an
+    // empty symbol table.
+    symcount = 0;
+    current_scope = 0;
+    unit->call_count = 0;
+    unit->cacheable = 1;
+
+    parsing_unit = unit;
+    scan_in_place(src, len);
+    yyparse();
+    end_scan();
+    parsing_unit = NULL;
+
+    if (func_count != first_function + 1) {
+        fprintf(stderr, "Error: Expected one function per definition\n");
+        abort_compile();
+    }
+    unit->ast = root;
+    unit->info = functions[func_count - 1];
+
+    // Lets tests see which functions were parsed rather than reused.
+    if (getenv("VIBE_TRACE_CACHE")) {
+        fprintf(stderr, "Parsed function '%s'\n", unit->info.name);
+    }
+}
+
+void compile_source(char* src, int len) {
+    free_program_chain();
+    func_count = 0;
+    compile_count++;
+    for (int i = 0; i < unit_count; i++) {
+        units[i].used = 0;
+    }
+
+    int start = 0;
+    do {
+        int end = next_span_end(src, start, len);
+        if (program && is_blank(src, start, end)) break;
+
+        int length = end - start;
+        unsigned long long hash = hash_bytes(FNV_OFFSET, src + start, length);
+        CachedUnit* unit = find_unit(hash, src + start, length);
+        if (unit && unit->cacheable && unit_is_current(unit)) {
+            restore_function(&unit->info);
+        } else {
+            // A unit checked against callee signatures that have since
+            // changed is re-parsed into its own slot.
+            CachedUnit parsed;
+            parse_unit(&parsed, src + start, length);
+            if (unit) {
+                free_ast(unit->ast);
+                parsed.text = unit->text;
+            } else {
+                unit = claim_unit_slot();
+                parsed.text = malloc(length);
+                memcpy(parsed.text, src + start, length);
+            }
+            parsed.hash = hash;
+            parsed.length = length;
+            *unit = parsed;
+        }
+        unit->used = 1;
+        unit->last_used = compile_count;
+
+        program = program ? create_node("functions", program, unit->ast, NULL) : unit->ast;
+        start = end;
+    } while (start < len);
+
+    root = program;
+    check_main_defined();
+}
+
+int compile_guarded(char* src, int len) {
+    jmp_buf jump;
+    if (setjmp(jump)) {
+        error_jump = NULL;
+        return 1;
+    }
+    error_jump = &jump;
+    compile_source(src, len);
+    error_jump = NULL;
+    return 0;
+}
+
+void note_function_call(const char* func_name) {
+    if (!parsing_unit) return;
+
+    for (int i = 0; i < parsing_unit->call_count; i++) {
+        if (parsing_unit->calls[i] == func_name) return;
+    }
+    FunctionInfo* callee = find_function(func_name);
+    if (!callee) return;
+    if (parsing_unit->call_count >= MAX_UNIT_CALLS) {
+        parsing_unit->cacheable = 0;
+        return;
+    }
+    parsing_unit->calls[parsing_unit->call_count] = func_name;
+    parsing_unit->call_sigs[parsing_unit->call_count] = signature_hash(callee);
+    parsing_unit->call_count++;
+}
+
+void abort_compile() {
+    end_scan();
+    parsing_unit = NULL;
+    if (error_jump) {
+        longjmp(*error_jump, 1);
+    }
+    exit(1);
+}
@@ -0,0 +1,24 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "ast.h"
+
+// Compiles a whole program, reusing the parsed and checked AST of every
+// `plot` function whose source span was compiled before, by this or an
+// earlier program, and whose callees still have the signatures it was
+// checked against. Sets the global root. The lexer scans src in
+// place, so it must be writable and have two spare bytes after len.
+void compile_source(char* src, int len);
+
+// Same as compile_source, but a compile error returns 1 instead of
+// exiting, so a long-running compiler keeps its cache.
+int compile_guarded(char* src, int len);
+
+// Records that the function being parsed calls func_name, so its cached
+// result is dropped when that callee's signature changes.
+void note_function_call(const char* func_name);
+
+// Called after a compile error has been reported.
+void abort_compile();
+
+#endif
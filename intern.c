@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include <string.h>
+#include "intern.h"
+
+#define ARENA_BLOCK 65536
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct InternEntry {
+    const char* str;
+    int len;
+    unsigned int hash;
+} InternEntry;
+
+static InternEntry* table = NULL;
+static int table_size = 0;
+static int table_count = 0;
+
+// Interned strings are packed into large blocks instead of one malloc each.
+static char* arena = NULL;
+static int arena_left = 0;
+
+const char interned_main[] = "main";
+const char interned_print[] = "print";
+const char interned_void[] = "void";
+const char interned_int[] = "int";
+const char interned_float[] = "float";
+const char interned_string[] = "string";
+const char interned_bool[] = "bool";
+
+// Entered into the table before anything else is interned.
+static const char* const builtin_names[] = {
+    interned_main, interned_print, interned_void, interned_int,
+    interned_float, interned_string, interned_bool,
+};
+
+static unsigned int hash_string(const char* s, int len) {
+    unsigned int h = FNV_OFFSET;
+    for (int i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static char* arena_alloc(int size) {
+    if (size > arena_left) {
+        int block = size > ARENA_BLOCK ? size : ARENA_BLOCK;
+        arena = malloc(block);
+        arena_left = block;
+    }
+    char* p = arena;
+    arena += size;
+    arena_left -= size;
+    return p;
+}
+
+static void grow_table() {
+    int old_size = table_size;
+    InternEntry* old = table;
+    table_size = old_size ? old_size * 2 : 1024;
+    table = calloc(table_size, sizeof(InternEntry));
+    table_count = 0;
+    for (int i = 0; i < old_size; i++) {
+        if (!old[i].str) continue;
+        int slot = old[i].hash & (table_size - 1);
+        while (table[slot].str) slot = (slot + 1) & (table_size - 1);
+        table[slot] = old[i];
+        table_count++;
+    }
+    free(old);
+}
+
+// Returns the entry for s, adding it if it is new. A new entry is
+// canonical itself when given, and otherwise a copy in the arena.
+static const char* find_or_add(const char* s, int len, const char* canonical) {
+    if (table_count * 2 >= table_size) grow_table();
+
+    unsigned int hash = hash_string(s, len);
+    int slot = hash & (table_size - 1);
+    while (table[slot].str) {
+        if (table[slot].hash == hash && table[slot].len == len && memcmp(table[slot].str, s, len) == 0) {
+            return table[slot].str;
+        }
+        slot = (slot + 1) & (table_size - 1);
+    }
+
+    if (!canonical) {
+        char* copy = arena_alloc(len + 1);
+        memcpy(copy, s, len);
+        copy[len] = '\0';
+        canonical = copy;
+    }
+    table[slot].str = canonical;
+    table[slot].len = len;
+    table[slot].hash = hash;
+    table_count++;
+    return canonical;
+}
+
+const char* intern(const char* s, int len) {
+    if (!table) {
+        int count = sizeof(builtin_names) / sizeof(builtin_names[0]);
+        for (int i = 0; i < count; i++) {
+            find_or_add(builtin_names[i], strlen(builtin_names[i]), builtin_names[i]);
+        }
+    }
+    return find_or_add(s, len, NULL);
+}
+
+const char* intern_cstr(const char* s) {
+    return intern(s, strlen(s));
+}
@@ -0,0 +1,22 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+// Returns the canonical copy of the len bytes at s. Equal strings always
+// intern to the same pointer, so interned names compare with ==.
+// Interned strings live until the process exits, so only identifiers and
+// type names are interned, never literal values.
+const char* intern(const char* s, int len);
+const char* intern_cstr(const char* s);
+
+// The canonical copies of names the compiler and interpreter compare
+// against, so those comparisons need no lookup: intern("main") returns
+// interned_main, and so on.
+extern const char interned_main[];
+extern const char interned_print[];
+extern const char interned_void[];
+extern const char interned_int[];
+extern const char interned_float[];
+extern const char interned_string[];
+extern const char interned_bool[];
+
+#endif
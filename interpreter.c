@@ -4,11 +4,12 @@
 #include <stdbool.h>
 #include "ast.h"
 #include "vibe.h"
+#include "intern.h"
 
 extern ast_node* root;
 
 typedef struct {
-    char* name;
+    const char* name;     // interned, compared by pointer
     char* type;
     union {
         int int_val;
@@ -63,7 +64,7 @@ void interpret(ast_node* node) {
     }
     else if (strcmp(node->node_type, "decl_assign") == 0) {
         Variable value = evaluate_expression(node->right);
-        variables[var_count].name = strdup(node->left->value);
+        variables[var_count].name = node->left->value;
         variables[var_count].type = strdup(node->type);
         variables[var_count].value = value.value;
         var_count++;
@@ -104,7 +105,7 @@ void interpret(ast_node* node) {
 }
 
 void interpret_function(ast_node* node) {
-    if (strcmp(node->value, "main") == 0) {
+    if (node->value == interned_main) {
         interpret(node->left);
     }
 }
@@ -131,30 +132,20 @@ void interpret_assignment(ast_node* node) {
     var->value = value.value;
 }
 
+// "if" and "else_if" nodes hold the condition on the left and a "branches"
+// node on the right, whose left is the taken block and right the rest.
 void interpret_conditional(ast_node* node) {
-    if (strcmp(node->node_type, "if") == 0) {
+    if (strcmp(node->node_type, "if") == 0 || strcmp(node->node_type, "else_if") == 0) {
         Variable cond = evaluate_expression(node->left);
         if (strcmp(cond.type, "bool") != 0) {
             fprintf(stderr, "Error: Condition must be boolean\n");
             exit(1);
         }
         if (cond.value.bool_val) {
-            interpret(node->right);
-        } else if (node->right && node->right->right) {
+            interpret(node->right->left);
+        } else {
             interpret(node->right->right);
         }
-    } 
-    else if (strcmp(node->node_type, "else_if") == 0) {
-        Variable cond = evaluate_expression(node->left);
-        if (strcmp(cond.type, "bool") != 0) {
-            fprintf(stderr, "Error: Condition must be boolean\n");
-            exit(1);
-        }
-        if (cond.value.bool_val) {
-            interpret(node->right);
-        } else if (node->right) {
-            interpret(node->right);
-        }
     }
     else {
         interpret(node->left);
@@ -201,7 +192,7 @@ void interpret_dowhile(ast_node* node) {
 }
 
 void interpret_func_call(ast_node* node) {
-    if (strcmp(node->value, "print") == 0) {
+    if (node->value == interned_print) {
         interpret_print(node);
         return;
     }
@@ -487,7 +478,7 @@ Variable evaluate_literal(ast_node* node) {
 
 Variable* find_variable(const char* name) {
     for (int i = var_count - 1; i >= 0; i--) {
-        if (strcmp(variables[i].name, name) == 0) {
+        if (variables[i].name == name) {
             return &variables[i];
         }
     }
@@ -2,9 +2,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "ast.h"
 #include "vibe.h"
 #include "interpreter.h"
+#include "incremental.h"
+#include "intern.h"
 
 void yyerror(const char *s);
 int yylex(void);
@@ -13,16 +24,15 @@ int yylex(void);
 ast_node* root;
 FunctionInfo* current_function;
 
-ast_node* create_node(char* type, ast_node* left, ast_node* right, char* value) {
+// value is either an interned name or, for literal nodes, a string the
+// node takes ownership of (freed with the tree by free_ast).
+ast_node* create_node(char* type, ast_node* left, ast_node* right, const char* value) {
     ast_node* new_node = (ast_node*)malloc(sizeof(ast_node));
     new_node->node_type = strdup(type);
     new_node->left = left;
     new_node->right = right;
     new_node->type = NULL;
-    if (value)
-        new_node->value = strdup(value);
-    else
-        new_node->value = NULL;
+    new_node->value = value;
     return new_node;
 }
 
@@ -37,17 +47,49 @@ void print_ast(ast_node* node, int level) {
     print_ast(node->right, level + 1);
 }
 
+void print_dot_escaped(const char* s) {
+    for (; *s; s++) {
+        if (*s == '\n') {
+            fputs("\\n", stdout);
+            continue;
+        }
+        if (*s == '"' || *s == '\\') putchar('\\');
+        putchar(*s);
+    }
+}
+
+// Prints node and its subtree as Graphviz statements, one per line, and
+// returns the id given to node.
+int print_ast_dot(ast_node* node, int* next_id) {
+    int id = (*next_id)++;
+    printf("  n%d [label=\"", id);
+    print_dot_escaped(node->node_type);
+    if (node->value) {
+        printf(" (");
+        print_dot_escaped(node->value);
+        printf(")");
+    }
+    if (node->type) {
+        printf(" : ");
+        print_dot_escaped(node->type);
+    }
+    printf("\"];\n");
+    if (node->left) printf("  n%d -> n%d;\n", id, print_ast_dot(node->left, next_id));
+    if (node->right) printf("  n%d -> n%d;\n", id, print_ast_dot(node->right, next_id));
+    return id;
+}
+
 void check_main_defined() {
     int main_found = 0;
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, "main") == 0 && functions[i].defined) {
+        if (functions[i].name == interned_main && functions[i].defined) {
             main_found = 1;
             break;
         }
     }
     if (!main_found) {
         fprintf(stderr, "Error: No main function defined\n");
-        exit(1);
+        abort_compile();
     }
 }
 %}
@@ -57,7 +99,7 @@ void check_main_defined() {
 %union {
     int ival;
     float fval;
-    char *sval;
+    const char *sval;
     int boolval;
     struct Symbol *sym;
     struct ast_node *ast;
@@ -83,8 +125,7 @@ void check_main_defined() {
 %start program
 
 %type <ast> program functions function params param_list param block statements statement declaration assignment expression conditional maybe_clauses loop dowhile func_call args arg_list return_stmt print_stmt
-%type <sval> IDENT STRING
-%type <ast> type 
+%type <sval> IDENT STRING type
 %type <ival> INT BOOLVAL
 %type <fval> FLOAT
 
@@ -93,9 +134,6 @@ void check_main_defined() {
 program: functions
     {
         root = $1;
-        printf("=== AST ===\n");
-        print_ast(root, 0);
-        check_main_defined();
     }
 ;
 
@@ -107,24 +145,24 @@ functions: functions function
 
 function: PLOT type IDENT LPAREN params RPAREN block
     {
-        add_function($3, $2->value);
+        add_function($3, $2);
         current_function = &functions[func_count-1];
         enter_scope();
         $$ = create_node("function", $7, NULL, $3);
-        $$->type = strdup($2->value);
+        $$->type = $2;
         exit_scope();
-        if (strcmp($3, "main") == 0) {
+        if ($3 == interned_main) {
             current_function->defined = 1;
         }
         current_function = NULL;
     }
 ;
 
-type: VOID_TYPE { $$ = create_node("type", NULL, NULL, "void"); }
-    | INT_TYPE { $$ = create_node("type", NULL, NULL, "int"); }
-    | FLOAT_TYPE { $$ = create_node("type", NULL, NULL, "float"); }
-    | STRING_TYPE { $$ = create_node("type", NULL, NULL, "string"); }
-    | BOOL_TYPE { $$ = create_node("type", NULL, NULL, "bool"); }
+type: VOID_TYPE { $$ = interned_void; }
+    | INT_TYPE { $$ = interned_int; }
+    | FLOAT_TYPE { $$ = interned_float; }
+    | STRING_TYPE { $$ = interned_string; }
+    | BOOL_TYPE { $$ = interned_bool; }
 ;
 
 params: param_list
@@ -139,8 +177,8 @@ param_list: param_list COMMA param
 
 param: type IDENT
     {
-        insert_symbol($2, "param", $1->value);  
-        add_function_param(current_function->name, $1->value);  // Use $1->value
+        insert_symbol($2, "param", $1);  
+        add_function_param(current_function->name, $1);
     }
 ;
 
@@ -175,25 +213,25 @@ declaration:
     {
         if (lookup_current_scope($3)) {
             fprintf(stderr, "Error: Redeclaration of '%s'\n", $3);
-            exit(1);
+            abort_compile();
         }
-        insert_symbol($3, "variable", $2->value);  // Use $2->value
+        insert_symbol($3, "variable", $2);
         $$ = create_node("declaration", NULL, NULL, $3);
-        $$->type = strdup($2->value);  // Use $2->value
+        $$->type = $2;
     }
     | VIBE type IDENT ASSIGN expression
     {
         if (lookup_current_scope($3)) {
             fprintf(stderr, "Error: Redeclaration of '%s'\n", $3);
-            exit(1);
+            abort_compile();
         }
-        if (strcmp($2->value, $5->type) != 0) {  // Use $2->value
+        if (strcmp($2, $5->type) != 0) {
             fprintf(stderr, "Error: Type mismatch in initialization of '%s'\n", $3);
-            exit(1);
+            abort_compile();
         }
-        insert_symbol($3, "variable", $2->value);  // Use $2->value
+        insert_symbol($3, "variable", $2);
         $$ = create_node("decl_assign", create_node("ID", NULL, NULL, $3), $5, NULL);
-        $$->type = strdup($2->value);  // Use $2->value
+        $$->type = $2;
     }
 ;
 assignment: IDENT ASSIGN expression
@@ -201,14 +239,14 @@ assignment: IDENT ASSIGN expression
         Symbol* s = lookup($1);
         if (!s) {
             fprintf(stderr, "Error: Variable '%s' not declared\n", $1);
-            exit(1);
+            abort_compile();
         }
         if (strcmp(s->type, $3->type) != 0) {
             fprintf(stderr, "Error: Type mismatch in assignment to '%s'\n", $1);
-            exit(1);
+            abort_compile();
         }
         $$ = create_node("assign", create_node("ID", NULL, NULL, $1), $3, NULL);
-        $$->type = strdup(s->type);
+        $$->type = intern_cstr(s->type);
     }
 ;
 
@@ -217,16 +255,16 @@ expression:
     { 
         if (strcmp($1->type, $3->type) != 0) { 
             fprintf(stderr, "Error: Type mismatch in addition\n"); 
-            exit(1); 
+            abort_compile(); 
         } 
         $$ = create_node("+", $1, $3, NULL);
-        $$->type = strdup($1->type);
+        $$->type = $1->type;
     }
     | expression MINUS expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in subtraction\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("-", $1, $3, NULL);
             $$->type = $1->type;
@@ -235,7 +273,7 @@ expression:
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in multiplication\n"); 
-                exit(1); 
+                abort_compile(); 
             } 
             $$ = create_node("*", $1, $3, NULL);
             $$->type = $1->type;
@@ -244,7 +282,7 @@ expression:
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in division\n"); 
-                exit(1); 
+                abort_compile(); 
             } 
             $$ = create_node("/", $1, $3, NULL);
             $$->type = $1->type;
@@ -253,82 +291,82 @@ expression:
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in equality comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("==", $1, $3, NULL);
-            $$->type = "bool";  // Equality returns boolean
+            $$->type = interned_bool;  // Equality returns boolean
         }
     | expression NEQ expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in inequality comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("!=", $1, $3, NULL);
-            $$->type = "bool";  // Inequality returns boolean
+            $$->type = interned_bool;  // Inequality returns boolean
         }
     | expression LT expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in less-than comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("<", $1, $3, NULL);
-            $$->type = "bool";  // Less than returns boolean
+            $$->type = interned_bool;  // Less than returns boolean
         }
     | expression GT expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in greater-than comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node(">", $1, $3, NULL);
-            $$->type = "bool";  // Greater than returns boolean
+            $$->type = interned_bool;  // Greater than returns boolean
         }
     | expression LE expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in less-than-or-equal comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("<=", $1, $3, NULL);
-            $$->type = "bool";  // Less than or equal returns boolean
+            $$->type = interned_bool;  // Less than or equal returns boolean
         }
     | expression GE expression 
         { 
             if (strcmp($1->type, $3->type) != 0) { 
                 fprintf(stderr, "Error: Type mismatch in greater-than-or-equal comparison\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node(">=", $1, $3, NULL);
-            $$->type = "bool";  // Greater than or equal returns boolean
+            $$->type = interned_bool;  // Greater than or equal returns boolean
         }
     | expression AND expression 
         { 
             if (strcmp($1->type, "bool") != 0 || strcmp($3->type, "bool") != 0) { 
                 fprintf(stderr, "Error: Type mismatch in AND operation\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("AND", $1, $3, NULL);
-            $$->type = "bool";  // AND returns boolean
+            $$->type = interned_bool;  // AND returns boolean
         }
     | expression OR expression 
         { 
             if (strcmp($1->type, "bool") != 0 || strcmp($3->type, "bool") != 0) { 
                 fprintf(stderr, "Error: Type mismatch in OR operation\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("OR", $1, $3, NULL);
-            $$->type = "bool";  // OR returns boolean
+            $$->type = interned_bool;  // OR returns boolean
         }
     | NOT expression 
         { 
             if (strcmp($2->type, "bool") != 0) { 
                 fprintf(stderr, "Error: Type mismatch in NOT operation\n"); 
-                exit(1); 
+                abort_compile(); 
             }
             $$ = create_node("NOT", $2, NULL, NULL);
-            $$->type = "bool";  // NOT returns boolean
+            $$->type = interned_bool;  // NOT returns boolean
         }
     | MINUS expression %prec UMINUS 
         { 
@@ -342,35 +380,35 @@ expression:
             Symbol* s = lookup($1);  // Check if variable is declared
             if (!s) {
                 fprintf(stderr, "Error: Variable '%s' not declared\n", $1);
-                exit(1);
+                abort_compile();
             }
             $$ = create_node("ID", NULL, NULL, $1);
-            $$->type = s->type;  // Set type to the variable's type
+            $$->type = intern_cstr(s->type);  // Set type to the variable's type
         }
     | INT 
         { 
             char buffer[20];
             sprintf(buffer, "%d", $1);
             $$ = create_node("INT", NULL, NULL, strdup(buffer));
-            $$->type = "int";  // Integer type
+            $$->type = interned_int;  // Integer type
         }
     | FLOAT 
         { 
             char buffer[20];
             sprintf(buffer, "%f", $1);
             $$ = create_node("FLOAT", NULL, NULL, strdup(buffer));
-            $$->type = "float";  // Float type
+            $$->type = interned_float;  // Float type
         }
     | STRING 
         { 
             $$ = create_node("STRING", NULL, NULL, $1);
-            $$->type = "string";  // String type
+            $$->type = interned_string;  // String type
         }
     | BOOLVAL 
         { 
             char *val = ($1) ? "true" : "false";
             $$ = create_node("BOOL", NULL, NULL, strdup(val));
-            $$->type = "bool";  // Boolean type
+            $$->type = interned_bool;  // Boolean type
         }
     | func_call { $$ = $1; }
 ;
@@ -379,12 +417,10 @@ conditional: YAH expression block maybe_clauses
     {
         if (strcmp($2->type, "bool") != 0) {
             fprintf(stderr, "Error: Condition must be boolean\n");
-            exit(1);
-        }
-        $$ = create_node("if", $2, $3, NULL);
-        if ($4) {
-            $$->right = create_node("else", $4, NULL, NULL);
+            abort_compile();
         }
+        ast_node* else_branch = $4 ? create_node("else", $4, NULL, NULL) : NULL;
+        $$ = create_node("if", $2, create_node("branches", $3, else_branch, NULL), NULL);
     }
 ;
 
@@ -393,12 +429,9 @@ maybe_clauses:
     {
         if (strcmp($2->type, "bool") != 0) {
             fprintf(stderr, "Error: Condition must be boolean\n");
-            exit(1);
-        }
-        $$ = create_node("else_if", $2, $3, NULL);
-        if ($4) {
-            $$->right = $4;
+            abort_compile();
         }
+        $$ = create_node("else_if", $2, create_node("branches", $3, $4, NULL), NULL);
     }
     | NAH block
     { $$ = $2; }
@@ -410,7 +443,7 @@ loop:
     {
         if (strcmp($5->type, "bool") != 0) {
             fprintf(stderr, "Error: Loop condition must be boolean\n");
-            exit(1);
+            abort_compile();
         }
         ast_node *init = $3;
         ast_node *cond = $5;
@@ -423,7 +456,7 @@ loop:
     {
         if (strcmp($2->type, "bool") != 0) {
             fprintf(stderr, "Error: Loop condition must be boolean\n");
-            exit(1);
+            abort_compile();
         }
         $$ = create_node("while_loop", $2, $3, NULL);
     }
@@ -433,7 +466,7 @@ dowhile: DOSTART block DOEND expression SEMICOLON
     {
         if (strcmp($4->type, "bool") != 0) {
             fprintf(stderr, "Error: Loop condition must be boolean\n");
-            exit(1);
+            abort_compile();
         }
         $$ = create_node("do_while", $2, $4, NULL);
     }
@@ -442,14 +475,15 @@ dowhile: DOSTART block DOEND expression SEMICOLON
 func_call: IDENT LPAREN args RPAREN
     {
         if (check_function_args($1, $3)) {
-            exit(1);
+            abort_compile();
         }
+        note_function_call($1);
         $$ = create_node("call", NULL, $3, $1);
         
         // Set return type
         for (int i = 0; i < func_count; i++) {
-            if (strcmp(functions[i].name, $1) == 0) {
-                $$->type = strdup(functions[i].return_type);
+            if (functions[i].name == $1) {
+                $$->type = intern_cstr(functions[i].return_type);
                 break;
             }
         }
@@ -463,7 +497,7 @@ args: arg_list
 arg_list: arg_list COMMA expression
     { 
         $$ = create_node("args", $1, $3, NULL); 
-        $$->type = strdup($3->type);
+        $$->type = $3->type;
     }
     | expression
     { $$ = $1; }
@@ -473,7 +507,7 @@ return_stmt: DROP
     {
         if (current_function && strcmp(current_function->return_type, "void") != 0) {
             fprintf(stderr, "Error: Non-void function missing return value\n");
-            exit(1);
+            abort_compile();
         }
         $$ = create_node("return", NULL, NULL, NULL);
     }
@@ -481,7 +515,7 @@ return_stmt: DROP
     {
         if (current_function && verify_return_type(current_function->name, $2->type)) {
             fprintf(stderr, "Error: Return type mismatch in function '%s'\n", current_function->name);
-            exit(1);
+            abort_compile();
         }
         $$ = create_node("return", $2, NULL, NULL);
     }
@@ -497,12 +531,221 @@ print_stmt: SPILL expression
 
 void yyerror(const char *s) {
     fprintf(stderr, "Error: %s\n", s);
-    exit(1);
+    abort_compile();
 }
 
-int main() {
-    yyparse();
-    
+// Both readers leave two spare bytes after the source for the lexer.
+char* read_source(FILE* in, int* len) {
+    int capacity = 4096;
+    char* src = malloc(capacity);
+    *len = 0;
+    int n;
+    while ((n = fread(src + *len, 1, capacity - 2 - *len, in)) > 0) {
+        *len += n;
+        if (*len == capacity - 2) {
+            capacity *= 2;
+            src = realloc(src, capacity);
+        }
+    }
+    return src;
+}
+
+// Maps the file privately, so the lexer can scan it in place without its
+// writes reaching the file. The mapping sits at the start of a zeroed
+// region two bytes longer than the file.
+char* map_source(const char* path, int* len) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        fprintf(stderr, "Error: Cannot read '%s'\n", path);
+        exit(1);
+    }
+    // Lengths are ints throughout, and the lexer needs two more bytes.
+    if (st.st_size > INT_MAX - 2) {
+        fprintf(stderr, "Error: Cannot map '%s'\n", path);
+        exit(1);
+    }
+    *len = st.st_size;
+    char* src = mmap(NULL, *len + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (src == MAP_FAILED ||
+        (*len > 0 && mmap(src, *len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)) {
+        fprintf(stderr, "Error: Cannot map '%s'\n", path);
+        exit(1);
+    }
+    close(fd);
+    return src;
+}
+
+// Programs that run longer than this are killed, so an endless loop
+// cannot run forever.
+#define RUN_TIMEOUT 10
+
+pid_t running_child = 0;
+volatile sig_atomic_t run_timed_out = 0;
+
+// SIGINT cancels the run and SIGALRM is its watchdog. Before the program
+// has started, or after it has finished, either one just ends the runner.
+void cancel_run(int sig) {
+    if (running_child > 0) {
+        if (sig == SIGALRM) run_timed_out = 1;
+        kill(running_child, SIGKILL);
+    } else {
+        _exit(1);
+    }
+}
+
+// Copies the running program's output to stdout as it arrives. Every line
+// is prefixed with "> " so program output can never look like a marker.
+void relay_output(int fd) {
+    char buffer[4096];
+    int line_start = 1;
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            if (line_start) fputs("> ", stdout);
+            putchar(buffer[i]);
+            line_start = buffer[i] == '\n';
+        }
+        fflush(stdout);
+    }
+    if (!line_start) putchar('\n');
+}
+
+// Runs the compiled program in a new runner process and returns its pid.
+// The runner connects to the Unix socket at socket_path, streams the
+// program's output there and ends it with an "=== END ===" line. It then
+// waits for the reader to close the socket before exiting, so its pid stays
+// valid for cancelling until the reader has seen the end of the run.
+pid_t start_run(const char* socket_path) {
+    pid_t runner = fork();
+    if (runner != 0) return runner;
+
+    close(STDIN_FILENO);
+    signal(SIGCHLD, SIG_DFL);
+    signal(SIGINT, cancel_run);
+    signal(SIGALRM, cancel_run);
+    alarm(RUN_TIMEOUT);
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        _exit(1);
+    }
+    dup2(sock, STDOUT_FILENO);
+    dup2(sock, STDERR_FILENO);
+
+    int output[2];
+    pipe(output);
+
+    // A SIGINT between fork() and setting running_child would otherwise
+    // find no program to kill and be lost.
+    sigset_t block, old_mask;
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGALRM);
+    sigprocmask(SIG_BLOCK, &block, &old_mask);
+    pid_t pid = fork();
+    if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGALRM, SIG_DFL);
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+        close(sock);
+        close(output[0]);
+        dup2(output[1], STDOUT_FILENO);
+        dup2(output[1], STDERR_FILENO);
+        close(output[1]);
+        interpret(root);
+        exit(0);
+    }
+    running_child = pid;
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+
+    close(output[1]);
+    relay_output(output[0]);
+    close(output[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    alarm(0);
+    running_child = 0;
+    if (WIFSIGNALED(status)) {
+        if (run_timed_out)
+            printf("Error: Execution timed out after %d seconds\n", RUN_TIMEOUT);
+        else if (WTERMSIG(status) == SIGKILL)
+            printf("Error: Execution cancelled\n");
+        else
+            printf("Error: Program terminated by signal %d\n", WTERMSIG(status));
+    }
+    printf("=== END ===\n");
+    fflush(stdout);
+
+    char byte;
+    shutdown(sock, SHUT_WR);
+    alarm(RUN_TIMEOUT);
+    while (read(sock, &byte, 1) > 0);
+    _exit(0);
+}
+
+// Long-running mode for the GUI. Each request is a command line followed
+// by the program source, and each response ends with an "=== END ===" line.
+// Unchanged functions are not re-parsed between requests.
+//
+//   run <length> <socket path>   prints the tree, then starts the program
+//       in its own runner process (see start_run) and reports its pid in
+//       an "=== RUN <pid> ===" line without waiting for it, so the next
+//       request can be compiled while earlier programs are still running.
+//   dot <length>   prints the tree as Graphviz source, for when the GUI
+//       is asked to draw it.
+int serve() {
+    int len;
+    char command[16];
+    char socket_path[108];
+    dup2(STDOUT_FILENO, STDERR_FILENO);
+    signal(SIGCHLD, SIG_IGN);
+    while (scanf("%15s %d", command, &len) == 2) {
+        int run = strcmp(command, "run") == 0;
+        if (run) scanf("%107s", socket_path);
+        getchar();
+        char* src = malloc(len + 2);
+        len = fread(src, 1, len, stdin);
+
+        if (compile_guarded(src, len) == 0) {
+            if (run) {
+                printf("=== AST ===\n");
+                print_ast(root, 0);
+                printf("\n===EXECUTION===\n");
+                fflush(stdout);
+                printf("=== RUN %d ===\n", start_run(socket_path));
+            } else {
+                int next_id = 0;
+                printf("digraph ast {\n");
+                print_ast_dot(root, &next_id);
+                printf("}\n");
+            }
+        }
+        free(src);
+        printf("=== END ===\n");
+        fflush(stdout);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // Flush program output a line at a time so a reader on the other end
+    // of a pipe sees it while the program is still running.
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0) {
+        return serve();
+    }
+
+    int len;
+    char* src = argc > 1 ? map_source(argv[1], &len) : read_source(stdin, &len);
+    compile_source(src, len);
+    printf("=== AST ===\n");
+    print_ast(root, 0);
+
     // After successful parsing, interpret the AST
     printf("\n===EXECUTION===\n");
     if (root) {
@@ -513,4 +756,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,71 @@
+"""Checks the per-function compile cache through `vibe --serve`.
+
+    check_cache.py [VIBE]
+
+VIBE defaults to ./vibe. Every case sends a sequence of programs to one
+compiler, as the GUI does, and looks at which functions were parsed
+rather than reused (reported when VIBE_TRACE_CACHE is set) and at the
+errors it reports.
+"""
+import os
+import subprocess
+import sys
+
+F_INT = "plot int f() {\n    drop 1;\n}\n"
+F_INT_BODY_EDIT = "plot int f() {\n    drop 2;\n}\n"
+F_STRING = "plot string f() {\n    drop \"one\";\n}\n"
+MAIN = "plot int main() {\n    vibe int x = f();\n    drop 0;\n}\n"
+OTHER = "plot int main() {\n    drop 0;\n}\n"
+
+
+def compile_all(vibe, programs):
+    """Returns, for each program, the functions parsed and the error lines."""
+    requests = "".join(f"dot {len(source)}\n{source}" for source in programs)
+    env = dict(os.environ, VIBE_TRACE_CACHE="1")
+    output = subprocess.run([vibe, "--serve"], input=requests.encode(), env=env,
+                            capture_output=True, timeout=30, check=True).stdout.decode()
+    results = []
+    for response in output.split("=== END ===\n")[:-1]:
+        lines = response.splitlines()
+        parsed = [line.split("'")[1] for line in lines if line.startswith("Parsed function")]
+        errors = [line for line in lines if line.startswith("Error")]
+        results.append((parsed, errors))
+    return results
+
+
+def check(name, got, expected):
+    if got != expected:
+        print(f"FAILED  {name}: expected {expected}, got {got}")
+        return False
+    print(f"ok      {name}")
+    return True
+
+
+def main(argv):
+    vibe = argv[1] if len(argv) > 1 else "./vibe"
+    ok = True
+
+    results = compile_all(vibe, [F_INT + MAIN, OTHER, F_INT + MAIN])
+    ok &= check("first compile parses everything", results[0], (["f", "main"], []))
+    ok &= check("unchanged functions are reused after another program",
+                results[2], ([], []))
+
+    results = compile_all(vibe, [F_INT + MAIN, F_INT_BODY_EDIT + MAIN])
+    ok &= check("a body-only edit of a callee reuses its caller", results[1], (["f"], []))
+
+    # main is re-checked against the new f and fails, so it is never
+    # reported as parsed; reusing it would report no error at all.
+    results = compile_all(vibe, [F_INT + MAIN, F_STRING + MAIN])
+    ok &= check("a changed callee signature invalidates its callers", results[1],
+                (["f"], ["Error: Type mismatch in initialization of 'x'"]))
+
+    results = compile_all(vibe, [F_INT + MAIN, F_INT_BODY_EDIT + MAIN,
+                                 F_INT + F_INT_BODY_EDIT + MAIN])
+    ok &= check("duplicate definitions restored from the cache are caught", results[2],
+                ([], ["Error: Function 'f' already declared"]))
+
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include "ast.h"
 #include "vibe.h"
+#include "incremental.h"
 
 Symbol symtab[1000];
 int symcount = 0;
@@ -12,12 +13,12 @@ int func_count = 0;
 
 void insert_symbol(const char* name, const char* role, const char* type) {
     for (int i = 0; i < symcount; i++) {
-        if (strcmp(symtab[i].name, name) == 0 && symtab[i].scope_level == current_scope) {
+        if (symtab[i].name == name && symtab[i].scope_level == current_scope) {
             fprintf(stderr, "Error: Redeclaration of '%s' in same scope\n", name);
-            exit(1);
+            abort_compile();
         }
     }
-    strcpy(symtab[symcount].name, name);
+    symtab[symcount].name = name;
     strcpy(symtab[symcount].role, role);
     strcpy(symtab[symcount].type, type);
     symtab[symcount].scope_level = current_scope;
@@ -26,7 +27,7 @@ void insert_symbol(const char* name, const char* role, const char* type) {
 
 Symbol* lookup(const char* name) {
     for (int i = symcount - 1; i >= 0; i--) {
-        if (strcmp(symtab[i].name, name) == 0) {
+        if (symtab[i].name == name) {
             return &symtab[i];
         }
     }
@@ -35,7 +36,7 @@ Symbol* lookup(const char* name) {
 
 Symbol* lookup_current_scope(const char* name) {
     for (int i = symcount - 1; i >= 0; i--) {
-        if (strcmp(symtab[i].name, name) == 0 && symtab[i].scope_level == current_scope) {
+        if (symtab[i].name == name && symtab[i].scope_level == current_scope) {
             return &symtab[i];
         }
     }
@@ -60,24 +61,35 @@ void exit_scope() {
 
 void add_function(const char* name, const char* return_type) {
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, name) == 0) {
+        if (functions[i].name == name) {
             fprintf(stderr, "Error: Function '%s' already declared\n", name);
-            exit(1);
+            abort_compile();
         }
     }
-    strcpy(functions[func_count].name, name);
+    functions[func_count].name = name;
     strcpy(functions[func_count].return_type, return_type);
     functions[func_count].param_count = 0;
     functions[func_count].defined = 0;
     func_count++;
 }
 
+void restore_function(const FunctionInfo* info) {
+    for (int i = 0; i < func_count; i++) {
+        if (functions[i].name == info->name) {
+            fprintf(stderr, "Error: Function '%s' already declared\n", info->name);
+            abort_compile();
+        }
+    }
+    functions[func_count] = *info;
+    func_count++;
+}
+
 void add_function_param(const char* func_name, const char* param_type) {
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, func_name) == 0) {
+        if (functions[i].name == func_name) {
             if (functions[i].param_count >= 10) {
                 fprintf(stderr, "Error: Too many parameters for function '%s'\n", func_name);
-                exit(1);
+                abort_compile();
             }
             strcpy(functions[i].param_types[functions[i].param_count], param_type);
             functions[i].param_count++;
@@ -85,13 +97,13 @@ void add_function_param(const char* func_name, const char* param_type) {
         }
     }
     fprintf(stderr, "Error: Function '%s' not found when adding param\n", func_name);
-    exit(1);
+    abort_compile();
 }
 
 int check_function_args(const char* func_name, ast_node* args) {
     FunctionInfo* func = NULL;
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, func_name) == 0) {
+        if (functions[i].name == func_name) {
             func = &functions[i];
             break;
         }
@@ -132,7 +144,7 @@ int check_function_args(const char* func_name, ast_node* args) {
 
 int verify_return_type(const char* func_name, const char* return_type) {
     for (int i = 0; i < func_count; i++) {
-        if (strcmp(functions[i].name, func_name) == 0) {
+        if (functions[i].name == func_name) {
             if (strcmp(functions[i].return_type, return_type) != 0) {
                 fprintf(stderr, "Error: Return type mismatch for function '%s'\n", func_name);
                 return 1;
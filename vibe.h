@@ -1,15 +1,17 @@
 #ifndef VIBE_H
 #define VIBE_H
 
+// Symbol and function names are interned (see intern.h) and compared by
+// pointer.
 typedef struct Symbol {
-    char name[100];
+    const char* name;
     char type[20];
     char role[20];
     int scope_level;
 } Symbol;
 
 typedef struct FunctionInfo {
-    char name[100];
+    const char* name;
     char return_type[20];
     char param_types[10][20];
     int param_count;
@@ -33,6 +35,7 @@ typedef struct ast_node ast_node;
 
 int check_function_args(const char* func_name, ast_node* args);
 void add_function(const char* name, const char* return_type);
+void restore_function(const FunctionInfo* info);
 void add_function_param(const char* func_name, const char* param_type);
 int verify_return_type(const char* func_name, const char* return_type);
 
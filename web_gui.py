@@ -1,8 +1,14 @@
-from flask import Flask, request, render_template_string, send_file
+from flask import Flask, Response, abort, request, render_template_string
+from collections import OrderedDict
+import hashlib
 import subprocess
-import tempfile
 import os
-from graphviz import Digraph
+import shutil
+import signal
+import socket
+import tempfile
+import threading
+import uuid
 
 app = Flask(__name__)
 
@@ -22,93 +28,327 @@ TEMPLATE = """
 <body>
   <div class="left">
     <h1>Vibe Code</h1>
-    <form method="post">
-      <textarea name="code">{{ code }}</textarea><br>
+    <form id="compile-form">
+      <textarea name="code"></textarea><br>
       <input type="submit" value="Compile">
+      <button type="button" id="cancel" disabled>Cancel</button>
     </form>
 
-    {% if output %}
     <h2>Output</h2>
-    <pre>{{ output }}</pre>
-    {% endif %}
+    <pre id="output"></pre>
   </div>
   <div class="right">
-    <h2>Parser Tree (AST)</h2>
-    {% if show_ast %}
-      <img src="/ast_image">
-    {% else %}
-      <p>No AST available</p>
-    {% endif %}
+    <details id="ast-view">
+      <summary><h2 style="display: inline">Parser Tree (AST)</h2></summary>
+      <img id="ast" hidden>
+      <p id="no-ast">No AST available</p>
+    </details>
   </div>
+  <script>
+    const form = document.getElementById("compile-form");
+    const output = document.getElementById("output");
+    const cancel = document.getElementById("cancel");
+    const astView = document.getElementById("ast-view");
+    const ast = document.getElementById("ast");
+    const noAst = document.getElementById("no-ast");
+    let runId = null;
+    let astUrl = null;
+
+    // The tree is only rendered once the AST view is open.
+    function showAst() {
+      if (!astView.open || !astUrl) return;
+      if (ast.getAttribute("src") !== astUrl) ast.src = astUrl;
+      ast.hidden = false;
+      noAst.hidden = true;
+    }
+    astView.addEventListener("toggle", showAst);
+
+    // A tree that could not be drawn shows why instead.
+    ast.addEventListener("error", async () => {
+      const response = await fetch(ast.src);
+      astUrl = null;
+      ast.hidden = true;
+      noAst.textContent = await response.text();
+      noAst.hidden = false;
+    });
+
+    function handleEvent(block) {
+      let type = "message";
+      const data = [];
+      for (const line of block.split("\\n")) {
+        if (line.startsWith("event: ")) type = line.slice(7);
+        else if (line.startsWith("data: ")) data.push(line.slice(6));
+      }
+      if (type === "run") {
+        runId = data.join("\\n");
+      } else if (type === "output") {
+        output.textContent += data.join("\\n") + "\\n";
+      } else if (type === "ast") {
+        astUrl = data.join("\\n");
+        showAst();
+      }
+    }
+
+    form.addEventListener("submit", async (event) => {
+      event.preventDefault();
+      output.textContent = "";
+      astUrl = null;
+      ast.hidden = true;
+      noAst.textContent = "No AST available";
+      noAst.hidden = false;
+      cancel.disabled = false;
+
+      const response = await fetch("/run", { method: "POST", body: new FormData(form) });
+      const reader = response.body.getReader();
+      const decoder = new TextDecoder();
+      let buffer = "";
+      while (true) {
+        const { value, done } = await reader.read();
+        if (done) break;
+        buffer += decoder.decode(value, { stream: true });
+        let end;
+        while ((end = buffer.indexOf("\\n\\n")) >= 0) {
+          handleEvent(buffer.slice(0, end));
+          buffer = buffer.slice(end + 2);
+        }
+      }
+      cancel.disabled = true;
+      runId = null;
+    });
+
+    cancel.addEventListener("click", () => {
+      if (runId) fetch("/cancel", { method: "POST", body: new URLSearchParams({ run: runId }) });
+    });
+  </script>
 </body>
 </html>
 """
 
-@app.route("/", methods=["GET", "POST"])
-def index():
-    code = ""
-    output = ""
-    show_ast = False
+# One long-running compiler keeps its per-function cache between compiles,
+# so an edit only re-parses the functions that changed. compiler_lock is
+# only held while a program compiles; the compiler then starts it in a
+# runner process of its own, which streams its output back over a Unix
+# socket. runs maps each live run id to its runner's pid for /cancel.
+compiler = None
+compiler_lock = threading.Lock()
+runs = {}
+runs_lock = threading.Lock()
+RUNNER_CONNECT_TIMEOUT = 5
+KEEPALIVE_INTERVAL = 1
+
+def send_to_compiler(command, source):
+    """Sends one request to the compiler and returns its output lines.
+    The caller holds compiler_lock."""
+    global compiler
+    if compiler is None or compiler.poll() is not None:
+        compiler = subprocess.Popen(
+            ["./vibe", "--serve"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            cwd=os.getcwd()
+        )
+    compiler.stdin.write(f"{command}\n".encode() + source)
+    compiler.stdin.flush()
+    lines = []
+    for line in iter(compiler.stdout.readline, b""):
+        if line == b"=== END ===\n":
+            break
+        lines.append(line.decode(errors="replace").rstrip("\n"))
+    return lines
 
-    if request.method == "POST":
-        code = request.form["code"]
-        with tempfile.NamedTemporaryFile(mode="w+", suffix=".vibe", delete=False) as f:
-            f.write(code)
-            temp_file = f.name
+def compile_program(source, socket_path):
+    """Compiles source and returns the compiler's output lines and the pid
+    of the runner it started, or None if the program did not compile."""
+    with compiler_lock:
+        lines = send_to_compiler(f"run {len(source)} {socket_path}", source)
+    runner = None
+    for line in lines:
+        if line.startswith("=== RUN "):
+            runner = int(line.split()[2])
+    return [line for line in lines if not line.startswith("=== RUN ")], runner
 
+def compile_dot(source):
+    """Returns the Graphviz source for the tree of source."""
+    with compiler_lock:
+        return "\n".join(send_to_compiler(f"dot {len(source)}", source))
+
+def run_program(code, run_id):
+    """Yields the compiler's output, then the program's, line by line while
+    the program runs, and None while the program is quiet."""
+    workdir = tempfile.mkdtemp()
+    socket_path = os.path.join(workdir, "run.sock")
+    listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    connection = None
+    finished = False
+    try:
+        listener.bind(socket_path)
+        listener.listen(1)
+        lines, runner = compile_program(code.encode(), socket_path)
+        yield from lines
+        if runner is None:
+            return
+        with runs_lock:
+            runs[run_id] = runner
+
+        listener.settimeout(RUNNER_CONNECT_TIMEOUT)
         try:
-            result = subprocess.run(
-                f"./vibe < {temp_file}",
-                shell=True,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.PIPE,
-                text=True,
-                cwd=os.getcwd()
-            )
-            output = result.stdout + "\n" + result.stderr
-            if "=== AST ===" in output:
-                show_ast = True
-                generate_ast_image(output)
-        finally:
-            os.remove(temp_file)
-
-    return render_template_string(TEMPLATE, code=code, output=output, show_ast=show_ast)
-
-@app.route("/ast_image")
-def ast_image():
-    return send_file("ast.png", mimetype="image/png")
-
-def generate_ast_image(output):
-    dot = Digraph(format='png')
-    lines = output.splitlines()
-    stack = []
-    last_id = 0
-
-    def new_id():
-        nonlocal last_id
-        last_id += 1
-        return f"node{last_id}"
+            connection, _ = listener.accept()
+        except socket.timeout:
+            yield "Error: Program did not start"
+            return
+        # While the program is quiet, yield None about once a second so the
+        # caller writes something and notices if the browser has gone.
+        connection.settimeout(KEEPALIVE_INTERVAL)
+        pending = b""
+        while not finished:
+            try:
+                chunk = connection.recv(4096)
+            except socket.timeout:
+                yield None
+                continue
+            if not chunk:
+                break
+            pending += chunk
+            while b"\n" in pending and not finished:
+                line, pending = pending.split(b"\n", 1)
+                if line == b"=== END ===":
+                    finished = True
+                else:
+                    yield line.decode(errors="replace")
+    finally:
+        with runs_lock:
+            runner = runs.pop(run_id, None)
+            if runner is not None and not finished:
+                # The browser went away mid-run: stop the program.
+                try:
+                    os.kill(runner, signal.SIGINT)
+                except ProcessLookupError:
+                    pass
+        # Closing the socket lets the runner exit.
+        if connection is not None:
+            connection.close()
+        listener.close()
+        shutil.rmtree(workdir, ignore_errors=True)
 
-    for line in lines:
-        if line.strip() == "=== AST ===":
-            stack.clear()
-            continue
-        if line.startswith("==="):
-            break
-        indent = len(line) - len(line.lstrip())
-        label = line.strip()
-        node_id = new_id()
-        dot.node(node_id, label)
-        if stack and indent > stack[-1][0]:
-            dot.edge(stack[-1][1], node_id)
-        else:
-            while stack and indent <= stack[-1][0]:
-                stack.pop()
-            if stack:
-                dot.edge(stack[-1][1], node_id)
-        stack.append((indent, node_id))
-
-    dot.render("ast", cleanup=True)
+# Programs whose tree can be drawn, keyed by a hash of the tree itself (its
+# text form, which every compile prints anyway) so that edits which leave
+# the tree alone, such as whitespace, reuse the drawing. Each entry keeps
+# one source with that tree, and the SVG once someone has looked at it.
+# The tree is only turned into Graphviz source and rendered when /ast is
+# asked for it. Entries are dropped least recently used first once they
+# hold more than AST_CACHE_BYTES, which keeps thousands of typical
+# programs, so a tree is still there when its page gets round to opening
+# the AST view.
+AST_CACHE_BYTES = 64 * 1024 * 1024
+RENDER_TIMEOUT = 10
+ast_cache = OrderedDict()
+ast_cache_bytes = 0
+ast_cache_lock = threading.Lock()
+
+def entry_size(entry):
+    return len(entry["source"]) + len(entry["svg"] or b"")
+
+def cache_ast(tree, source):
+    global ast_cache_bytes
+    key = hashlib.sha256(tree.encode()).hexdigest()
+    with ast_cache_lock:
+        if key not in ast_cache:
+            ast_cache[key] = {"source": source, "svg": None, "lock": threading.Lock()}
+            ast_cache_bytes += len(source)
+        ast_cache.move_to_end(key)
+        trim_ast_cache()
+    return key
+
+def trim_ast_cache():
+    global ast_cache_bytes
+    while ast_cache_bytes > AST_CACHE_BYTES and len(ast_cache) > 1:
+        _, entry = ast_cache.popitem(last=False)
+        ast_cache_bytes -= entry_size(entry)
+
+def render_ast(key, entry):
+    """Renders entry's tree once; concurrent requests for the same tree wait
+    for the first one instead of starting another Graphviz."""
+    global ast_cache_bytes
+    with entry["lock"]:
+        if entry["svg"] is None:
+            dot = compile_dot(entry["source"])
+            svg = subprocess.run(["dot", "-Tsvg"], input=dot.encode(), capture_output=True,
+                                 check=True, timeout=RENDER_TIMEOUT).stdout
+            with ast_cache_lock:
+                entry["svg"] = svg
+                if ast_cache.get(key) is entry:
+                    ast_cache_bytes += len(svg)
+                    trim_ast_cache()
+        return entry["svg"]
+
+def sse(event, data):
+    return f"event: {event}\ndata: {data}\n\n"
+
+@app.route("/")
+def index():
+    return render_template_string(TEMPLATE)
+
+@app.route("/run", methods=["POST"])
+def run():
+    code = request.form["code"]
+    run_id = uuid.uuid4().hex
+
+    def events():
+        yield sse("run", run_id)
+        tree = None
+        for line in run_program(code, run_id):
+            if line is None:
+                yield ": keepalive\n\n"
+                continue
+            if line == "=== AST ===":
+                tree = []
+            elif line == "===EXECUTION===" and tree is not None:
+                key = cache_ast("\n".join(tree), code.encode())
+                tree = None
+                yield sse("ast", f"/ast/{key}.svg")
+            elif tree is not None:
+                tree.append(line)
+            # Program output arrives prefixed with "> "
+            if line.startswith("> "):
+                line = line[2:]
+            yield sse("output", line)
+        yield sse("done", "")
+
+    return Response(events(), mimetype="text/event-stream", headers={"Cache-Control": "no-cache"})
+
+@app.route("/cancel", methods=["POST"])
+def cancel():
+    # The runner waits for run_program to close its socket before exiting,
+    # so a pid still in runs cannot have been reused by another process.
+    with runs_lock:
+        runner = runs.get(request.form.get("run"))
+        if runner is not None:
+            try:
+                os.kill(runner, signal.SIGINT)
+            except ProcessLookupError:
+                pass
+    return "", 204
+
+def render_error(status, message):
+    return Response(message + "\n", status=status, mimetype="text/plain")
+
+@app.route("/ast/<key>.svg")
+def ast_svg(key):
+    with ast_cache_lock:
+        entry = ast_cache.get(key)
+    if entry is None:
+        abort(404)
+    try:
+        svg = render_ast(key, entry)
+    except subprocess.TimeoutExpired:
+        return render_error(504, f"Rendering the AST took longer than {RENDER_TIMEOUT} seconds")
+    except subprocess.CalledProcessError as error:
+        return render_error(500, "Graphviz could not render the AST: " +
+                            error.stderr.decode(errors="replace").strip())
+    except OSError as error:
+        return render_error(503, f"Graphviz 'dot' could not be run: {error.strerror}")
+    return Response(svg, mimetype="image/svg+xml",
+                    headers={"Cache-Control": "public, max-age=31536000, immutable"})
 
 if __name__ == "__main__":
     app.run(debug=True)